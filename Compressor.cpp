@@ -39,10 +39,11 @@ std::string Compressor::compress(const std::string& filename) {
   //Build frequency table of bytes from file
   int frequencyTable[256] = {};
   CountByteFrequencies(file, frequencyTable);
-  // Construct Huffman Tree
-  HuffmanTree tree(frequencyTable);
-  // Get mapping from bytes to its encoding as a sequence of bits
-  auto encode_map = tree.GetEncodingMap();
+  // Construct Huffman Tree, which also fills build_state_ with
+  // each byte's encoding as a sequence of bits and its length
+  HuffmanTree tree(frequencyTable, build_state_);
+  const unsigned long long* codes = build_state_.codes;
+  const int* code_lengths = build_state_.code_lengths;
   
   // Write compressed file
   // 0. Open a new file to write the data into
@@ -70,10 +71,10 @@ std::string Compressor::compress(const std::string& filename) {
   int bit_index = 0; // Start at bit 0 (the rightmost bit)
   char c = '\0';
   while(file.get(c)) {
-    std::vector<bool> encoded_byte = encode_map[static_cast<unsigned char>(c)];
-    // Read all bits in the encoding of byte c
-    for(bool bit : encoded_byte) {
-      bit_accumulator[bit_index] = bit;
+    unsigned char byte = static_cast<unsigned char>(c);
+    // Read all bits in the encoding of byte c, first bit in the lowest place
+    for(int i = 0; i < code_lengths[byte]; i++) {
+      bit_accumulator[bit_index] = (codes[byte] >> i) & 1;
       bit_index++;
       if (bit_index == 8) {
         // Write byte to file
@@ -17,6 +17,8 @@ class Compressor {
 
   private:
     static const std::string compressed_file_extension_;
+    // Scratch memory reused each time a Huffman tree is built
+    HuffmanBuildState build_state_;
 
     bool FileExists(const std::string& filename);
     int GetFileLength(std::ifstream& file);
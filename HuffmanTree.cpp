@@ -1,4 +1,5 @@
 #include "HuffmanTree.h"
+#include <algorithm> // std::fill, std::copy, std::max, std::swap
 
 // Public Methods
 // **************
@@ -58,6 +59,27 @@ HuffmanTree::HuffmanTree(int byte_frequencies[256]) {
 }
 
 
+// Construct HuffmanTree from frequency table in linear time, using the
+// caller's scratch memory. Bytes are radix sorted by frequency, code lengths
+// are found with a two-queue merge, and canonical codes are assigned.
+// The codes are left in state.codes and state.code_lengths for encoding,
+// and the tree is built from them so it can be flattened as usual.
+HuffmanTree::HuffmanTree
+    (const int byte_frequencies[256], HuffmanBuildState& state) 
+    : root_(nullptr) {
+  SortSymbolsByFrequency(byte_frequencies, state);
+  ComputeCodeLengths(state);
+  AssignCanonicalCodes(state);
+  // Insert a path for each byte that appeared at least once.
+  // If there were no bytes, the root stays nullptr.
+  for(int byte = 0; byte < 256; byte++) {
+    if(state.code_lengths[byte] > 0) {
+      InsertCode(byte, state.codes[byte], state.code_lengths[byte]);
+    }
+  }
+}
+
+
 // Free all nodes of the HuffmanTree, starting at the root
 HuffmanTree::~HuffmanTree() {
   Erase(root_);
@@ -152,3 +174,141 @@ void HuffmanTree::Erase(BitNode* node) {
   // Delete this node (postorder)
   delete node;
 }
+
+// Fill state.symbols with the bytes that appeared at least once, sorted by
+// ascending frequency (ties in byte order), and state.weights with their
+// frequencies. Uses an LSD radix sort with 8-bit digits, skipping digits
+// above the largest frequency, so small blocks need only 1 or 2 passes.
+void HuffmanTree::SortSymbolsByFrequency
+    (const int byte_frequencies[256], HuffmanBuildState& state) {
+  int n = 0;
+  int max_frequency = 0;
+  for(int byte = 0; byte < 256; byte++) {
+    if(byte_frequencies[byte] > 0) {
+      state.symbols[n++] = byte;
+      max_frequency = std::max(max_frequency, byte_frequencies[byte]);
+    }
+  }
+  state.symbol_count = n;
+
+  unsigned char* in = state.symbols;
+  unsigned char* out = state.sort_buffer;
+  for(int shift = 0; shift < 32 && (max_frequency >> shift) > 0; shift += 8) {
+    // Count occurrences of each digit
+    std::fill(state.digit_counts, state.digit_counts + 256, 0);
+    for(int i = 0; i < n; i++) {
+      state.digit_counts[(byte_frequencies[in[i]] >> shift) & 0xFF]++;
+    }
+    // Turn counts into starting positions
+    int position = 0;
+    for(int digit = 0; digit < 256; digit++) {
+      int count = state.digit_counts[digit];
+      state.digit_counts[digit] = position;
+      position += count;
+    }
+    // Stable scatter into the other buffer, then swap buffers
+    for(int i = 0; i < n; i++) {
+      int digit = (byte_frequencies[in[i]] >> shift) & 0xFF;
+      out[state.digit_counts[digit]++] = in[i];
+    }
+    std::swap(in, out);
+  }
+  // After an odd number of passes the result is in the scratch buffer
+  if(in != state.symbols) {
+    std::copy(in, in + n, state.symbols);
+  }
+  for(int i = 0; i < n; i++) {
+    state.weights[i] = byte_frequencies[state.symbols[i]];
+  }
+}
+
+// Compute the code length of each byte into state.code_lengths
+// from the sorted leaves in state.symbols and state.weights.
+//
+// Leaves occupy indices [0, n) and merged nodes are appended at [n, 2n-1).
+// Since leaves are sorted and each merged node weighs at least as much as
+// the one before it, both ranges are queues in ascending order, so the two
+// lightest nodes are always at the front of one of them. No heap is needed.
+void HuffmanTree::ComputeCodeLengths(HuffmanBuildState& state) {
+  int n = state.symbol_count;
+  std::fill(state.code_lengths, state.code_lengths + 256, 0);
+  if(n == 0) return;
+  // A single byte still needs 1 bit, matching the tree where
+  // the root has that byte as its left child
+  if(n == 1) {
+    state.code_lengths[state.symbols[0]] = 1;
+    return;
+  }
+  int leaf = 0;    // front of leaf queue
+  int merged = n;  // front of merged node queue
+  for(int next = n; next < 2 * n - 1; next++) {
+    // Take the two lightest nodes, preferring leaves on ties
+    int lightest[2];
+    for(int k = 0; k < 2; k++) {
+      if(leaf < n && (merged == next || 
+          state.weights[leaf] <= state.weights[merged])) {
+        lightest[k] = leaf++;
+      } else {
+        lightest[k] = merged++;
+      }
+    }
+    state.weights[next] = state.weights[lightest[0]] + state.weights[lightest[1]];
+    state.parents[lightest[0]] = next;
+    state.parents[lightest[1]] = next;
+  }
+  // The last merged node is the root. Parents always have higher indices
+  // than their children, so one backward pass assigns every depth.
+  int root = 2 * n - 2;
+  state.depths[root] = 0;
+  for(int i = root - 1; i >= 0; i--) {
+    state.depths[i] = state.depths[state.parents[i]] + 1;
+  }
+  for(int i = 0; i < n; i++) {
+    state.code_lengths[state.symbols[i]] = state.depths[i];
+  }
+}
+
+// Assign canonical codes from state.code_lengths into state.codes:
+// shorter codes come first, and codes of equal length are in byte order.
+// Only the lengths matter for compression, and the decompressor reads
+// the flattened tree, so any prefix code with these lengths works.
+void HuffmanTree::AssignCanonicalCodes(HuffmanBuildState& state) {
+  const int max_length = HuffmanBuildState::max_code_length;
+  std::fill(state.length_counts, state.length_counts + max_length + 1, 0);
+  for(int byte = 0; byte < 256; byte++) {
+    state.length_counts[state.code_lengths[byte]]++;
+  }
+  state.length_counts[0] = 0;
+  // Find the first code of each length
+  unsigned long long code = 0;
+  for(int length = 1; length <= max_length; length++) {
+    code = (code + state.length_counts[length - 1]) << 1;
+    state.next_code[length] = code;
+  }
+  for(int byte = 0; byte < 256; byte++) {
+    int length = state.code_lengths[byte];
+    state.codes[byte] = 0;
+    if(length == 0) continue;
+    // Canonical codes read from the most significant bit, so reverse them
+    // to put the first bit (from the root) in the least significant bit
+    code = state.next_code[length]++;
+    for(int i = 0; i < length; i++) {
+      state.codes[byte] = (state.codes[byte] << 1) | ((code >> i) & 1);
+    }
+  }
+}
+
+// Add the path for a byte's code to the tree, creating nonterminal
+// nodes as needed. 0 = false goes left and 1 = true goes right.
+void HuffmanTree::InsertCode
+    (unsigned char byte, unsigned long long code, int length) {
+  if(root_ == nullptr) root_ = new BitNode(0, false);
+  BitNode* node = root_;
+  for(int i = 0; i < length; i++) {
+    BitNode*& child = ((code >> i) & 1) ? node->right : node->left;
+    if(child == nullptr) child = new BitNode(0, false);
+    node = child;
+  }
+  node->terminal = true;
+  node->byte = byte;
+}
@@ -24,10 +24,35 @@ struct BitNode {
       {}
 };
 
+// Scratch memory and results for building Huffman codes in linear time.
+// Owned by the caller so the same arrays can be reused across many builds
+// instead of allocating nodes and maps each time.
+struct HuffmanBuildState {
+  // Frequencies must sum to at most INT_MAX (the largest supported file),
+  // which bounds the depth of the tree well below this limit
+  static const int max_code_length = 64;
+
+  int symbol_count;                 // number of bytes with frequency > 0
+  unsigned char symbols[256];       // bytes sorted by ascending frequency
+  unsigned char sort_buffer[256];   // radix sort scratch space
+  int digit_counts[256];            // radix sort histogram
+  long long weights[511];           // sorted leaf weights, then merged nodes
+  int parents[511];                 // index of each node's parent
+  int depths[511];                  // depth of each node in the tree
+  int length_counts[max_code_length + 1];
+  unsigned long long next_code[max_code_length + 1];
+
+  // Results, indexed by byte. A length of 0 means the byte does not appear.
+  // Codes hold bits in stream order: the first bit (from the root) is the LSB.
+  int code_lengths[256];
+  unsigned long long codes[256];
+};
+
 class HuffmanTree {
   public:
     HuffmanTree(BitNode* root_in = nullptr);
     HuffmanTree(int byte_frequencies[256]);
+    HuffmanTree(const int byte_frequencies[256], HuffmanBuildState& state);
     ~HuffmanTree();
     BitNode* root();
 
@@ -41,6 +66,12 @@ class HuffmanTree {
   private:
     BitNode* root_;
     void Erase(BitNode* node);
+
+    static void SortSymbolsByFrequency
+        (const int byte_frequencies[256], HuffmanBuildState& state);
+    static void ComputeCodeLengths(HuffmanBuildState& state);
+    static void AssignCanonicalCodes(HuffmanBuildState& state);
+    void InsertCode(unsigned char byte, unsigned long long code, int length);
 };
 
 